@@ -0,0 +1,71 @@
+/*
+ *  This file is part of libmona
+ *
+ *  Libmona is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  Libmona is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with libmona; if not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MONA_CLIENT_H
+#define MONA_CLIENT_H
+
+#include <time.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mona/core.h>
+
+#define MONA_SOCKET "/tmp/mona.sock"
+
+enum mona_query
+{
+    MONA_QUERY_WAYPOINT,
+    MONA_QUERY_ZODIAC,
+    MONA_QUERY_LUNAR,
+    MONA_QUERY_SOLAR
+};
+
+enum mona_status
+{
+    MONA_STATUS_OK,
+    MONA_STATUS_INVALID
+};
+
+struct mona_request
+{
+    uint32_t id;
+    uint16_t query, object;
+    int64_t utc;
+    double latitude, longitude;
+};
+
+struct mona_response
+{
+    uint32_t id;
+    uint16_t query, status;
+    union
+    {
+        struct mona_waypoint waypoint;
+        struct mona_zodiac zodiac;
+        struct mona_lunar lunar;
+        struct mona_solar solar;
+    } data;
+};
+
+int mona_client_connect(const char *path);
+int mona_client_send(int fd, const struct mona_request *r, size_t count);
+int mona_client_receive(int fd, struct mona_response *r, size_t count);
+int mona_client_query(int fd, const struct mona_request *r,
+                      struct mona_response *out);
+void mona_client_close(int fd);
+
+#endif
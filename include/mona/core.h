@@ -96,6 +96,14 @@ enum mona_object
     MONA_OBJECT_JUPITER,
     MONA_OBJECT_SATURN,
 
+    /* Keplerian, for 3000 BC to AD 3000 and closest from 1800 to 2050,
+       no position in libraries built with MONA_NO_OUTER */
+    MONA_OBJECT_URANUS,
+    MONA_OBJECT_NEPTUNE,
+    MONA_OBJECT_PLUTO,
+    MONA_OBJECT_NORTH_NODE,
+    MONA_OBJECT_SOUTH_NODE,
+
     MONA_OBJECT_ASCENDANT,
     MONA_OBJECT_DESCENDANT,
     MONA_OBJECT_MEDIUM_COELI,
@@ -138,8 +146,63 @@ struct mona_solar
     enum mona_hour hour;
 };
 
+int mona_object_available(enum mona_object o);
 struct mona_zodiac mona_zodiac(struct mona_waypoint p, enum mona_object o);
 struct mona_lunar mona_lunar(struct mona_waypoint p);
 struct mona_solar mona_solar(struct mona_waypoint p);
 
+#define MONA_LUNAR_PHASE   (UINT32_C(1) << 0)
+#define MONA_LUNAR_BOUNDS  (UINT32_C(1) << 1)
+#define MONA_LUNAR_ALL     (UINT32_C(0x3))
+
+#define MONA_SOLAR_DEGREE  (UINT32_C(1) << 0)
+#define MONA_SOLAR_SEASON  (UINT32_C(1) << 1)
+#define MONA_SOLAR_BOUNDS  (UINT32_C(1) << 2)
+#define MONA_SOLAR_SUNRISE (UINT32_C(1) << 3)
+#define MONA_SOLAR_DAY     (UINT32_C(1) << 4)
+#define MONA_SOLAR_HOUR    (UINT32_C(1) << 5)
+#define MONA_SOLAR_ALL     (UINT32_C(0x3f))
+
+void mona_lunar_ex(struct mona_waypoint p, uint32_t fields,
+                   struct mona_lunar *out);
+void mona_solar_ex(struct mona_waypoint p, uint32_t fields,
+                   struct mona_solar *out);
+
+#define MONA_ANGLE_SIGN(a)    ((uint32_t)(((uint64_t)(a) * 12) >> 32))
+#define MONA_ANGLE_DECAN(a)   ((uint32_t)(((uint64_t)(a) * 36) >> 32) % 3)
+#define MONA_ANGLE_DEGREES(a) ((uint32_t)(((uint64_t)(a) * 360) >> 32) % 30)
+
+uint32_t mona_angle(struct mona_waypoint p, enum mona_object o);
+uint32_t mona_angle_zodiac(struct mona_zodiac z);
+struct mona_zodiac mona_zodiac_angle(uint32_t a);
+
+#define MONA_TABLE_STEP     2
+#define MONA_TABLE_LATITUDE 60
+#define MONA_TABLE_ROWS     61
+#define MONA_TABLE_COLUMNS  (360 / MONA_TABLE_STEP)
+
+struct mona_table
+{
+    double tilt, error;
+    float descendant[MONA_TABLE_ROWS][MONA_TABLE_COLUMNS];
+    float imum_coeli[MONA_TABLE_COLUMNS];
+};
+
+void mona_table(struct mona_table *t, double j2k);
+struct mona_zodiac mona_zodiac_table(const struct mona_table *t,
+                                     struct mona_waypoint p,
+                                     enum mona_object o);
+
+/* Every object before the angles, the lunar nodes included */
+#define MONA_RISING_OBJECT(o) (UINT32_C(1) << (o))
+#define MONA_RISING_ALL       ((UINT32_C(1) << MONA_OBJECT_ASCENDANT) - 1)
+
+struct mona_rising
+{
+    time_t rise, transit, set;
+};
+
+void mona_risings(struct mona_waypoint p, uint32_t mask,
+                  struct mona_rising out[MONA_OBJECT_COUNT]);
+
 #endif
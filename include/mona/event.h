@@ -0,0 +1,91 @@
+/*
+ *  This file is part of libmona
+ *
+ *  Libmona is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  Libmona is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with libmona; if not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MONA_EVENT_H
+#define MONA_EVENT_H
+
+#include <time.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mona/core.h>
+
+enum mona_field
+{
+    MONA_FIELD_HOUR,
+    MONA_FIELD_DAY,
+    MONA_FIELD_SEASON,
+    MONA_FIELD_MOON,
+    MONA_FIELD_SIGN,
+    MONA_FIELD_DECAN,
+
+    MONA_FIELD_COUNT
+};
+
+#define MONA_CHANGE_FIELD(f)  (UINT32_C(1) << (f))
+#define MONA_CHANGE_OBJECT(o) (UINT32_C(1) << (8 + (o)))
+
+struct mona_event
+{
+    time_t time;
+    enum mona_field field;
+    enum mona_object object;
+    uint8_t from, to;
+};
+
+time_t mona_next_change(struct mona_waypoint p, uint32_t mask,
+                        struct mona_event *event);
+
+#define MONA_PREDICATES 16
+#define MONA_VALUE(v)   (UINT32_C(1) << (v))
+
+struct mona_predicate
+{
+    enum mona_field field;
+    enum mona_object object;
+    uint32_t values;
+};
+
+struct mona_interval
+{
+    time_t beginning, ending;
+};
+
+/* Number of intervals found, (size_t)-1 for an empty range, too many
+   predicates or an unknown field or unavailable object in them */
+size_t mona_election(const struct mona_predicate *predicates, size_t count,
+                     double latitude, double longitude,
+                     time_t beginning, time_t ending,
+                     struct mona_interval *out, size_t max);
+
+#define MONA_STATISTICS        16
+#define MONA_STATISTICS_VALUES 12
+
+struct mona_statistics
+{
+    enum mona_field field;
+    enum mona_object object;
+
+    time_t seconds[MONA_STATISTICS_VALUES];
+    uint32_t entries[MONA_STATISTICS_VALUES];
+};
+
+int mona_statistics(struct mona_statistics *stats, size_t count,
+                    double latitude, double longitude,
+                    time_t beginning, time_t ending, unsigned threads);
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ *  This file is part of libmona
+ *
+ *  Libmona is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  Libmona is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with libmona; if not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+
+#include <mona/core.h>
+#include <mona/client.h>
+
+/* Auxiliary functions */
+
+static int
+transfer(int fd, void *data, size_t length, uint8_t out)
+{
+    uint8_t *bytes = data;
+
+    while (length > 0)
+    {
+        ssize_t n = (out) ? write(fd, bytes, length) : read(fd, bytes, length);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+
+        bytes += n;
+        length -= n;
+    }
+
+    return 0;
+}
+
+/* Client functions */
+
+extern int
+mona_client_connect(const char *path)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+
+    path = (path) ? path : MONA_SOCKET;
+    if (strlen(path) >= sizeof(addr.sun_path))
+        return -1;
+    strcpy(addr.sun_path, path);
+
+    int ret = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ret >= 0 && connect(ret, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(ret);
+        ret = -1;
+    }
+
+    return ret;
+}
+
+extern int
+mona_client_send(int fd, const struct mona_request *r, size_t count)
+{
+    return transfer(fd, (void *)r, count * sizeof(*r), 1);
+}
+
+extern int
+mona_client_receive(int fd, struct mona_response *r, size_t count)
+{
+    return transfer(fd, r, count * sizeof(*r), 0);
+}
+
+extern int
+mona_client_query(int fd, const struct mona_request *r,
+                  struct mona_response *out)
+{
+    int ret = mona_client_send(fd, r, 1);
+    if (ret == 0)
+        ret = mona_client_receive(fd, out, 1);
+    if (ret == 0 && out->status != MONA_STATUS_OK)
+        ret = -1;
+
+    return ret;
+}
+
+extern void
+mona_client_close(int fd)
+{
+    close(fd);
+}
@@ -104,7 +104,7 @@ pos_moon(double t)
 
     double nv0 = 0.0, nv1 = 0.0, nv2 = 0.0, nv3 = 0.0;
 
-    double coeff0[29][6] = {
+    static const double coeff0[29][6] = {
     { 6.28877383, 134.9634114,  477198.8676313,   89.970,  14.348,  -6.797},
     { 1.27401064, 100.7369970,  413335.3554020, -122.571, -10.684,   5.028},
     { 0.65830943, 235.7004084,  890534.2230335,  -32.601,   3.664,  -1.769},
@@ -142,20 +142,20 @@ pos_moon(double t)
                                           coeff0[i][5] * 10E-8 * t * t * t * t
                                          ));
 
-    double coeff2[6][3] = {{ 0.46578, 357.529,   35999.050},
-                           {-0.14345, 103.208,  377366.305},
-                           {-0.11495, 238.171,  854535.173},
-                           { 0.10310, 222.566, -441199.817},
-                           { 0.07656, 132.493,  513197.918},
-                           {-0.07062,  27.775,     131.849}};
+    static const double coeff2[6][3] = {{ 0.46578, 357.529,   35999.050},
+                                        {-0.14345, 103.208,  377366.305},
+                                        {-0.11495, 238.171,  854535.173},
+                                        { 0.10310, 222.566, -441199.817},
+                                        { 0.07656, 132.493,  513197.918},
+                                        {-0.07062,  27.775,     131.849}};
 
-    double coeff1[] = {3.95801, 119.7524, 131.8489};
+    static const double coeff1[] = {3.95801, 119.7524, 131.8489};
     nv1 += coeff1[0] * sin(radians(coeff1[1] + coeff1[2] * t));
 
     for (int i = 0; i < 6; i++)
         nv2 += coeff2[i][0] * sin(radians(coeff2[i][1] + coeff2[i][2] * t));
 
-    double coeff3[] = {13.53, 357.5, 35999.1};
+    static const double coeff3[] = {13.53, 357.5, 35999.1};
     nv3 += coeff3[0] * sin(radians(coeff3[1] + coeff3[2] * t));
 
     double l = 218.31665 + 481267.88134 * t - 13.268E-4 * t * t +
@@ -163,7 +163,7 @@ pos_moon(double t)
                nv0 + 10E-3 * (nv1 + t * nv2 + t * t * 10E-4 * nv3);
     l = fmod(l, 360.0);
 
-    return l;
+    return (l < 0.0) ? l + 360.0 : l;
 }
 
 static double
@@ -412,6 +412,131 @@ pos_saturn(double x0, double y0, double t)
     return degrees(polar(x0, y0, X, Y));
 }
 
+#ifndef MONA_NO_OUTER
+
+/*  Outer planets from J2000 Keplerian elements (Standish), the 1800-2050
+    set where it applies and the 3000 BC - AD 3000 set with its extra
+    mean anomaly terms outside of it, precessed to the equinox of date to
+    match VSOP87C */
+
+static double
+pos_kepler(double x0, double y0, double t, const double el[2][6][2],
+           const double fix[4])
+{
+    double T = t * 10.0;
+
+    int far = !(T >= -2.0 && T <= 0.5);
+    double a = el[far][0][0] + el[far][0][1] * T;
+    double e = el[far][1][0] + el[far][1][1] * T;
+    double I = radians(el[far][2][0] + el[far][2][1] * T);
+    double L = el[far][3][0] + el[far][3][1] * T;
+    double w = el[far][4][0] + el[far][4][1] * T;
+    double O = radians(el[far][5][0] + el[far][5][1] * T);
+
+    double M = L - w;
+    if (far)
+        M += fix[0] * T * T + fix[1] * cos(radians(fix[3] * T)) +
+             fix[2] * sin(radians(fix[3] * T));
+    M = radians(fmod(M, 360.0));
+    w = radians(w) - O;
+
+    double E = M + e * sin(M);
+    for (int i = 0; i < 4; i++)
+        E -= (E - e * sin(E) - M) / (1.0 - e * cos(E));
+
+    double x1 = a * (cos(E) - e);
+    double y1 = a * sqrt(1.0 - e * e) * sin(E);
+
+    double X = (cos(w) * cos(O) - sin(w) * sin(O) * cos(I)) * x1 +
+               (-sin(w) * cos(O) - cos(w) * sin(O) * cos(I)) * y1;
+    double Y = (cos(w) * sin(O) + sin(w) * cos(O) * cos(I)) * x1 +
+               (-sin(w) * sin(O) + cos(w) * cos(O) * cos(I)) * y1;
+
+    double pr = radians((5028.796195 * T + 1.1054348 * T * T) / 3600.0);
+    double Xd = X * cos(pr) - Y * sin(pr);
+    double Yd = X * sin(pr) + Y * cos(pr);
+
+    return degrees(polar(x0, y0, Xd, Yd));
+}
+
+static double
+pos_uranus(double x0, double y0, double t)
+{
+    static const double el[2][6][2] = {{{ 19.18916464,  -0.00196176},
+                                        {  0.04725744,  -0.00004397},
+                                        {  0.77263783,  -0.00242939},
+                                        {313.23810451, 428.48202785},
+                                        {170.95427630,   0.40805281},
+                                        { 74.01692503,   0.04240589}},
+                                       {{ 19.18797948,  -0.00020455},
+                                        {  0.04685740,  -0.00001550},
+                                        {  0.77298127,  -0.00180155},
+                                        {314.20276625, 428.49512595},
+                                        {172.43404441,   0.09266985},
+                                        { 73.96250215,   0.05739699}}};
+    static const double fix[4] = {0.00058331, -0.97731848, 0.17689245,
+                                  7.67025000};
+    return pos_kepler(x0, y0, t, el, fix);
+}
+
+static double
+pos_neptune(double x0, double y0, double t)
+{
+    static const double el[2][6][2] = {{{ 30.06992276,   0.00026291},
+                                        {  0.00859048,   0.00005105},
+                                        {  1.77004347,   0.00035372},
+                                        {-55.12002969, 218.45945325},
+                                        { 44.96476227,  -0.32241464},
+                                        {131.78422574,  -0.00508664}},
+                                       {{ 30.06952752,   0.00006447},
+                                        {  0.00895439,   0.00000818},
+                                        {  1.77005520,   0.00022400},
+                                        {304.22289287, 218.46515314},
+                                        { 46.68158724,   0.01009938},
+                                        {131.78635853,  -0.00606302}}};
+    static const double fix[4] = {-0.00041348, 0.68346318, -0.10162547,
+                                  7.67025000};
+    return pos_kepler(x0, y0, t, el, fix);
+}
+
+static double
+pos_pluto(double x0, double y0, double t)
+{
+    static const double el[2][6][2] = {{{ 39.48211675,  -0.00031596},
+                                        {  0.24882730,   0.00005170},
+                                        { 17.14001206,   0.00004818},
+                                        {238.92903833, 145.20780515},
+                                        {224.06891629,  -0.04062942},
+                                        {110.30393684,  -0.01183482}},
+                                       {{ 39.48686035,   0.00449751},
+                                        {  0.24885238,   0.00006016},
+                                        { 17.14104260,   0.00000501},
+                                        {238.96535011, 145.18042903},
+                                        {224.09702598,  -0.00968827},
+                                        {110.30167986,  -0.00809981}}};
+    static const double fix[4] = {-0.01262724, 0.0, 0.0, 0.0};
+    return pos_kepler(x0, y0, t, el, fix);
+}
+
+#endif
+
+/* Mean ascending node of the Moon, ELP2000 (Meeus) */
+
+static double
+pos_north_node(double t)
+{
+    double T = t * 10.0;
+    double node = 125.0445479 - 1934.1362891 * T + 0.0020754 * T * T +
+                  T * T * T / 467441.0 - T * T * T * T / 60616000.0;
+    return fmod(fmod(node, 360.0) + 360.0, 360.0);
+}
+
+static double
+pos_south_node(double t)
+{
+    return fmod(pos_north_node(t) + 180.0, 360.0);
+}
+
 /* Other objects functions */
 
 static double
@@ -437,24 +562,33 @@ local_sidereal(double j2k, double longitude)
 }
 
 static double
-pos_descendant(double j2k, double latitude, double longitude)
+horizon(double tilt, double latitude, double lst)
 {
-    double tilt = tilt_earth(j2k);
-    double lst = local_sidereal(j2k, longitude);
     return degrees(atan2(-cos(lst), tan(radians(latitude)) * sin(tilt) +
                                     sin(lst)               * cos(tilt)));
 }
+
+static double
+pos_descendant(double j2k, double latitude, double longitude)
+{
+    return horizon(tilt_earth(j2k), latitude, local_sidereal(j2k, longitude));
+}
 static double
 pos_ascendant(double j2k, double latitude, double longitude)
 {
     return fmod(pos_descendant(j2k, latitude, longitude) + 180.0, 360.0);
 }
 
+static double
+meridian(double tilt, double lst)
+{
+    return degrees(atan2(-sin(lst), -cos(lst) * cos(tilt)));
+}
+
 static double
 pos_imum_coeli(double j2k, double longitude)
 {
-    return degrees(atan2(tan(local_sidereal(j2k, longitude)),
-                   cos(tilt_earth(j2k))));
+    return meridian(tilt_earth(j2k), local_sidereal(j2k, longitude));
 }
 
 static double
@@ -465,27 +599,31 @@ pos_medium_coeli(double j2k, double longitude)
 
 /* Astrologic conversions */
 
-extern struct mona_waypoint
-mona_waypoint(time_t utc, double latitude, double longitude)
+static struct mona_zodiac
+zodiac(double deg)
 {
-    struct mona_waypoint ret = {0};
+    struct mona_zodiac ret = {0};
 
-    ret.latitude = latitude;
-    ret.longitude = longitude;
-    ret.j2k = j2000(utc);
+    ret.position = deg;
+    if (!isfinite(deg))
+        return ret;
 
-    ret.T = variable_T(ret.j2k);
-    ref_earth(&(ret.X), &(ret.Y), ret.T);
+    ret.sign = floor(deg / 30.0);
+    deg = fmod(deg, 30.0);
+
+    ret.decan = floor(deg / 10.0);
+    ret.degrees = floor(deg);
+    deg = fmod(deg, 1.0);
+
+    ret.seconds = round(deg * 60.0);
 
     return ret;
 }
 
-extern struct mona_zodiac
-mona_zodiac(struct mona_waypoint p, enum mona_object o)
+static double
+position(struct mona_waypoint p, enum mona_object o)
 {
     /* Zodiac object position */
-    struct mona_zodiac ret = {0};
-
     double deg = 0;
     switch (o)
     {
@@ -510,6 +648,29 @@ mona_zodiac(struct mona_waypoint p, enum mona_object o)
         case MONA_OBJECT_SATURN:
             deg = pos_saturn(p.X, p.Y, p.T);
             break;
+#ifndef MONA_NO_OUTER
+        case MONA_OBJECT_URANUS:
+            deg = pos_uranus(p.X, p.Y, p.T);
+            break;
+        case MONA_OBJECT_NEPTUNE:
+            deg = pos_neptune(p.X, p.Y, p.T);
+            break;
+        case MONA_OBJECT_PLUTO:
+            deg = pos_pluto(p.X, p.Y, p.T);
+            break;
+#else
+        case MONA_OBJECT_URANUS:
+        case MONA_OBJECT_NEPTUNE:
+        case MONA_OBJECT_PLUTO:
+            deg = NAN;
+            break;
+#endif
+        case MONA_OBJECT_NORTH_NODE:
+            deg = pos_north_node(p.T);
+            break;
+        case MONA_OBJECT_SOUTH_NODE:
+            deg = pos_south_node(p.T);
+            break;
 
         case MONA_OBJECT_ASCENDANT:
             deg = pos_ascendant(p.j2k, p.latitude, p.longitude);
@@ -526,22 +687,202 @@ mona_zodiac(struct mona_waypoint p, enum mona_object o)
         default:
             break;
     }
-    ret.position = deg;
 
-    ret.sign = floor(deg / 30.0);
-    deg = fmod(deg, 30.0);
+    return deg;
+}
 
-    ret.decan = floor(deg / 10.0);
-    ret.degrees = floor(deg);
-    deg = fmod(deg, 1.0);
+extern struct mona_waypoint
+mona_waypoint(time_t utc, double latitude, double longitude)
+{
+    struct mona_waypoint ret = {0};
 
-    ret.seconds = round(deg * 60.0);
+    ret.latitude = latitude;
+    ret.longitude = longitude;
+    ret.j2k = j2000(utc);
+
+    ret.T = variable_T(ret.j2k);
+    ref_earth(&(ret.X), &(ret.Y), ret.T);
 
     return ret;
 }
 
-extern struct mona_lunar
-mona_lunar(struct mona_waypoint p)
+extern int
+mona_object_available(enum mona_object o)
+{
+#ifdef MONA_NO_OUTER
+    if (o >= MONA_OBJECT_URANUS && o <= MONA_OBJECT_PLUTO)
+        return 0;
+#endif
+
+    return o < MONA_OBJECT_COUNT;
+}
+
+extern struct mona_zodiac
+mona_zodiac(struct mona_waypoint p, enum mona_object o)
+{
+    return zodiac(position(p, o));
+}
+
+/* Binary angles */
+
+static uint32_t
+angle(double deg)
+{
+    if (!isfinite(deg))
+        return 0;
+
+    return (uint32_t)(int64_t)floor(deg * (4294967296.0 / 360.0) + 0.5);
+}
+
+extern uint32_t
+mona_angle(struct mona_waypoint p, enum mona_object o)
+{
+    return angle(position(p, o));
+}
+
+extern uint32_t
+mona_angle_zodiac(struct mona_zodiac z)
+{
+    return angle(z.position);
+}
+
+extern struct mona_zodiac
+mona_zodiac_angle(uint32_t a)
+{
+    struct mona_zodiac ret = {0};
+
+    ret.position = a * (360.0 / 4294967296.0);
+
+    ret.sign = MONA_ANGLE_SIGN(a);
+    ret.decan = MONA_ANGLE_DECAN(a);
+    ret.degrees = MONA_ANGLE_DEGREES(a);
+
+    /* Minutes as 32.32 fixed point, rounded like the double path */
+    uint64_t m = (uint64_t)a * 21600;
+    ret.seconds = (uint32_t)(m >> 32) % 60 + ((uint32_t)m >= 0x80000000u);
+
+    return ret;
+}
+
+/* Table of houses */
+
+static double
+table_angle(const float *row, double column)
+{
+    int i = column;
+    i = (i < 0) ? 0 : (i >= MONA_TABLE_COLUMNS) ? MONA_TABLE_COLUMNS - 1 : i;
+    int j = (i + 1) % MONA_TABLE_COLUMNS;
+
+    double a = row[i], b = row[j];
+    if (b - a > 180.0)
+        b -= 360.0;
+    else if (a - b > 180.0)
+        b += 360.0;
+
+    return a + (b - a) * (column - i);
+}
+
+static double
+table_descendant(const struct mona_table *t, double latitude, double lst)
+{
+    /* Rows are evenly spaced on tan(latitude), the formula is linear in it */
+    double span = tan(radians(MONA_TABLE_LATITUDE));
+    double column = degrees(lst) / MONA_TABLE_STEP;
+    double row = (tan(radians(latitude)) + span) / (2.0 * span) *
+                 (MONA_TABLE_ROWS - 1);
+
+    int i = row;
+    i = (i < 0) ? 0 : (i >= MONA_TABLE_ROWS - 1) ? MONA_TABLE_ROWS - 2 : i;
+
+    double a = table_angle(t->descendant[i], column);
+    double b = table_angle(t->descendant[i + 1], column);
+    if (b - a > 180.0)
+        b -= 360.0;
+    else if (a - b > 180.0)
+        b += 360.0;
+
+    return fmod(a + (b - a) * (row - i) + 360.0, 360.0);
+}
+
+extern void
+mona_table(struct mona_table *t, double j2k)
+{
+    double tilt = tilt_earth(j2k);
+    t->tilt = tilt;
+
+    double span = tan(radians(MONA_TABLE_LATITUDE));
+    for (int i = 0; i < MONA_TABLE_ROWS; i++)
+    {
+        double u = (2.0 * span * i) / (MONA_TABLE_ROWS - 1) - span;
+        double latitude = atan(u) * (180.0 / M_PI);
+        for (int j = 0; j < MONA_TABLE_COLUMNS; j++)
+            t->descendant[i][j] = horizon(tilt, latitude,
+                                          radians(j * MONA_TABLE_STEP));
+    }
+
+    for (int j = 0; j < MONA_TABLE_COLUMNS; j++)
+    {
+        t->imum_coeli[j] = meridian(tilt, radians(j * MONA_TABLE_STEP));
+    }
+
+    /*  Error bound, the worst case sits halfway between columns, sampled
+        on and halfway between rows it matches a sampling 500 times finer */
+    double error = 0.0;
+    for (int i = 0; i <= (MONA_TABLE_ROWS - 1) * 2; i++)
+    {
+        double u = (2.0 * span * i) / ((MONA_TABLE_ROWS - 1) * 2) - span;
+        double latitude = atan(u) * (180.0 / M_PI);
+        for (int j = 0; j < MONA_TABLE_COLUMNS; j++)
+        {
+            double lst = radians((j + 0.5) * MONA_TABLE_STEP);
+            double d = fabs(table_descendant(t, latitude, lst) -
+                            horizon(tilt, latitude, lst));
+            d = (d > 180.0) ? 360.0 - d : d;
+            error = (d > error) ? d : error;
+        }
+    }
+    t->error = error;
+}
+
+extern struct mona_zodiac
+mona_zodiac_table(const struct mona_table *t, struct mona_waypoint p,
+                  enum mona_object o)
+{
+    /* Written so that NaN takes the exact path as well */
+    if (!(p.latitude >= -MONA_TABLE_LATITUDE &&
+          p.latitude <= MONA_TABLE_LATITUDE))
+        return mona_zodiac(p, o);
+
+    double lst = local_sidereal(p.j2k, p.longitude);
+    if (!isfinite(lst))
+        return mona_zodiac(p, o);
+
+    double deg = 0;
+    switch (o)
+    {
+        case MONA_OBJECT_ASCENDANT:
+            deg = fmod(table_descendant(t, p.latitude, lst) + 180.0, 360.0);
+            break;
+        case MONA_OBJECT_DESCENDANT:
+            deg = table_descendant(t, p.latitude, lst);
+            break;
+        case MONA_OBJECT_MEDIUM_COELI:
+            deg = table_angle(t->imum_coeli, degrees(lst) / MONA_TABLE_STEP);
+            deg = fmod(deg + 180.0 + 360.0, 360.0);
+            break;
+        case MONA_OBJECT_IMUM_COELI:
+            deg = table_angle(t->imum_coeli, degrees(lst) / MONA_TABLE_STEP);
+            deg = fmod(deg + 360.0, 360.0);
+            break;
+        default:
+            return mona_zodiac(p, o);
+    }
+
+    return zodiac(deg);
+}
+
+extern void
+mona_lunar_ex(struct mona_waypoint p, uint32_t fields, struct mona_lunar *out)
 {
     /* Moon phase calculations */
     struct mona_lunar ret = {0};
@@ -550,94 +891,290 @@ mona_lunar(struct mona_waypoint p)
 
     double age = fmod(p.j2k + 142.25, length);
     age = (age < 0.0) ? age + length : age;
-    ret.age = age;
 
-    double deg = (age / length) * 360.0;
-    ret.phase = floor(deg / 45.0);
-    ret.degree = deg;
+    if (fields & MONA_LUNAR_PHASE)
+    {
+        ret.age = age;
+
+        double deg = (age / length) * 360.0;
+        ret.phase = floor(deg / 45.0);
+        ret.degree = deg;
+    }
+
+    if (fields & MONA_LUNAR_BOUNDS)
+    {
+        ret.beginning = epoch(p.j2k - age);
+        ret.ending = epoch(p.j2k + (length - age));
+    }
 
-    ret.beginning = epoch(p.j2k - age);
-    ret.ending = epoch(p.j2k + (length - age));
+    *out = ret;
+}
 
+extern struct mona_lunar
+mona_lunar(struct mona_waypoint p)
+{
+    struct mona_lunar ret;
+    mona_lunar_ex(p, MONA_LUNAR_ALL, &ret);
     return ret;
 }
 
-extern struct mona_solar
-mona_solar(struct mona_waypoint p)
+extern void
+mona_solar_ex(struct mona_waypoint p, uint32_t fields, struct mona_solar *out)
 {
     /* Solar calculations */
     struct mona_solar ret = {0};
 
     double mst = floor(p.j2k) - (p.longitude / 360.0);
-    double M = fmod(357.5291 + 0.98560028 * mst, 360.0);
-    double C = 1.9148 * sin(radians(M)) +
-                 0.02 * sin(radians(2.0 * M)) +
-               0.0003 * sin(radians(3.0 * M));
-    double el = fmod((M + C + 180.0 + 102.9372), 360.0);
 
-    ret.degree = el;
+    double M = 0.0, el = 0.0;
+    if (fields & ~MONA_SOLAR_DAY)
+    {
+        M = fmod(fmod(357.5291 + 0.98560028 * mst, 360.0) + 360.0, 360.0);
+        double C = 1.9148 * sin(radians(M)) +
+                     0.02 * sin(radians(2.0 * M)) +
+                   0.0003 * sin(radians(3.0 * M));
+        el = fmod((M + C + 180.0 + 102.9372), 360.0);
+    }
 
     uint8_t phase = el / 90.0;
     double age = (el / 360.0) * 365.25;
-    ret.age = age;
 
-    double coeffs[4][5] = {
-        {2451623.80984, 365242.37404,  0.05169, -0.00411, -0.00057},
-        {2451716.56767, 365241.62603,  0.00325,  0.00888, -0.00030},
-        {2451810.21715, 365242.01767, -0.11575,  0.00337,  0.00078},
-        {2451900.05952, 365242.74049, -0.06223, -0.00823,  0.00032}
-    };
+    if (fields & MONA_SOLAR_DEGREE)
+    {
+        ret.degree = el;
+        ret.age = age;
+    }
+
+    if (fields & MONA_SOLAR_SEASON)
+        ret.season = fmod(phase + 2.0 * (p.latitude < 0.0), 4.0);
 
-    time_t beg = 0.0;
-    time_t end = 0.0;
+    if (fields & MONA_SOLAR_BOUNDS)
+    {
+        static const double coeffs[4][5] = {
+            {2451623.80984, 365242.37404,  0.05169, -0.00411, -0.00057},
+            {2451716.56767, 365241.62603,  0.00325,  0.00888, -0.00030},
+            {2451810.21715, 365242.01767, -0.11575,  0.00337,  0.00078},
+            {2451900.05952, 365242.74049, -0.06223, -0.00823,  0.00032}
+        };
+
+        time_t beg = 0.0;
+        time_t end = 0.0;
+
+        uint8_t sources[] = {phase, (phase + 1) % 4};
+        time_t *targets[] = {&(beg), &(end)};
+        for (int i = 0; i < 2; i++)
+        {
+            double delta = ((i == 0) ? 90.0 : 90.0) - fmod(age, 90.0);
+
+            uint8_t x = sources[i];
+            double T = floor((p.j2k + delta) / 365.25) / 1000.0;
+
+            double date = coeffs[x][0] + coeffs[x][1] * T +
+                                         coeffs[x][2] * T * T +
+                                         coeffs[x][3] * T * T * T +
+                                         coeffs[x][4] * T * T * T * T;
+            *(targets[i]) = epoch(date - 2451545.0);
+        }
+
+        ret.beginning = beg;
+        ret.ending = end;
+    }
 
-    uint8_t sources[] = {phase, (phase + 1) % 4};
-    time_t *targets[] = {&(beg), &(end)};
-    for (int i = 0; i < 2; i++)
+    /* Sunrise / Sunset */
+    double jt = 0.0, hr = 0.0;
+    if (fields & (MONA_SOLAR_SUNRISE | MONA_SOLAR_HOUR))
     {
-        double delta = ((i == 0) ? 90.0 : 90.0) - fmod(age, 90.0);
+        jt = mst + 0.0053 * sin(radians(M)) -
+                   0.0069 * sin(radians(2.0 * el));
 
-        uint8_t x = sources[i];
-        double T = floor((p.j2k + delta) / 365.25) / 1000.0;
+        double dec = asin(sin(radians(el)) * 0.39778370349);
+        hr = acos((-0.0145380805 - sin(radians(p.latitude)) * sin(dec)) /
+                                  (cos(radians(p.latitude)) * cos(dec)));
+        hr /= (2.0 * M_PI);
+    }
+
+    if (fields & MONA_SOLAR_SUNRISE)
+    {
+        ret.sunrise = epoch(jt - hr);
+        ret.sunset  = epoch(jt + hr);
+    }
 
-        double date = coeffs[x][0] + coeffs[x][1] * T +
-                                     coeffs[x][2] * T * T +
-                                     coeffs[x][3] * T * T * T +
-                                     coeffs[x][4] * T * T * T * T;
-        *(targets[i]) = epoch(date - 2451545.0);
+    /* Planetary day and hour */
+    if (fields & (MONA_SOLAR_DAY | MONA_SOLAR_HOUR))
+    {
+        enum mona_day d = fmod(fmod(floor(p.j2k - 1.0), 7.0) + 7.0, 7.0);
+        if (fields & MONA_SOLAR_DAY)
+            ret.day = d;
+
+        if (fields & MONA_SOLAR_HOUR)
+        {
+            switch (d)
+            {
+                case MONA_DAY_SUN:     ret.hour = MONA_HOUR_SUN;     break;
+                case MONA_DAY_MOON:    ret.hour = MONA_HOUR_MOON;    break;
+                case MONA_DAY_MARS:    ret.hour = MONA_HOUR_MARS;    break;
+                case MONA_DAY_MERCURY: ret.hour = MONA_HOUR_MERCURY; break;
+                case MONA_DAY_JUPITER: ret.hour = MONA_HOUR_JUPITER; break;
+                case MONA_DAY_VENUS:   ret.hour = MONA_HOUR_VENUS;   break;
+                case MONA_DAY_SATURN:  ret.hour = MONA_HOUR_SATURN;  break;
+            }
+            ret.hour = fmod(fmod((p.j2k - (jt - hr)) / (hr / 6.0) + ret.hour,
+                                 7.0) + 7.0, 7.0);
+        }
     }
 
-    ret.season = fmod(phase + 2.0 * (p.latitude < 0.0), 4.0);
-    ret.beginning = beg;
-    ret.ending = end;
+    *out = ret;
+}
 
-    /* Sunrise / Sunset */
-    double jt = mst + 0.0053 * sin(radians(M)) -
-                      0.0069 * sin(radians(2.0 * el));
+extern struct mona_solar
+mona_solar(struct mona_waypoint p)
+{
+    struct mona_solar ret;
+    mona_solar_ex(p, MONA_SOLAR_ALL, &ret);
+    return ret;
+}
 
-    double dec = asin(sin(radians(el)) * 0.39778370349);
-    double hr = acos((-0.0145380805 - sin(radians(p.latitude)) * sin(dec)) /
-                                     (cos(radians(p.latitude)) * cos(dec)));
-    hr /= (2.0 * M_PI);
+/*  Rise, transit and set
+    Meeus, the day is sampled three times for every body and the events
+    are refined on the interpolated positions */
 
-    ret.sunrise = epoch(jt - hr);
-    ret.sunset  = epoch(jt + hr);
+#define RISING_STEPS 8
+#define SIDEREAL     1.00273781191135448
 
-    /* Planetary day and hour */
-    enum mona_day d = fmod(fmod(floor(p.j2k - 1.0), 7.0) + 7.0, 7.0);
-    ret.day = d;
+struct sky
+{
+    double j2k, latitude;
+    double tilt, lst;
+};
+
+struct body
+{
+    double longitude, c1, c2;
+    double node, h0;
+};
+
+static double
+wrap(double deg)
+{
+    return deg - 360.0 * floor((deg + 180.0) / 360.0);
+}
 
-    switch (d)
+static double
+rising(const struct sky *s, const struct body *b, int side, double m)
+{
+    /* Fraction of the day, first step is folded back into the day */
+    for (int i = 0; i < RISING_STEPS; i++)
     {
-        case MONA_DAY_SUN:     ret.hour = MONA_HOUR_SUN;     break;
-        case MONA_DAY_MOON:    ret.hour = MONA_HOUR_MOON;    break;
-        case MONA_DAY_MARS:    ret.hour = MONA_HOUR_MARS;    break;
-        case MONA_DAY_MERCURY: ret.hour = MONA_HOUR_MERCURY; break;
-        case MONA_DAY_JUPITER: ret.hour = MONA_HOUR_JUPITER; break;
-        case MONA_DAY_VENUS:   ret.hour = MONA_HOUR_VENUS;   break;
-        case MONA_DAY_SATURN:  ret.hour = MONA_HOUR_SATURN;  break;
+        double l = radians(b->longitude + b->c1 * m + b->c2 * m * m);
+        double lat = (b->node < 0.0) ? 0.0 :
+                     radians(5.128 * sin(l - radians(b->node)));
+
+        double ra = atan2(sin(l) * cos(s->tilt) - tan(lat) * sin(s->tilt),
+                          cos(l));
+        double dec = asin(sin(lat) * cos(s->tilt) +
+                          cos(lat) * sin(s->tilt) * sin(l));
+
+        double ha = 0.0;
+        if (side)
+        {
+            double phi = radians(s->latitude);
+            double c = (sin(radians(b->h0)) - sin(phi) * sin(dec)) /
+                       (cos(phi) * cos(dec));
+            if (c < -1.0 || c > 1.0)
+                return -1.0;
+            ha = side * acos(c);
+        }
+
+        double lst = s->lst + 2.0 * M_PI * SIDEREAL * m;
+        double dm = -radians(wrap(degrees(lst - ra - ha))) /
+                    (2.0 * M_PI * SIDEREAL);
+
+        m += dm;
+        if (i == 0 && m >= 0.0)
+            m -= floor(m);
+        else if (fabs(dm) < 1E-6)
+            break;
     }
-    ret.hour = fmod((p.j2k - (jt - hr)) / (hr / 6.0) + ret.hour, 7.0);
 
-    return ret;
+    return m;
+}
+
+static time_t
+rising_time(const struct sky *s, const struct body *b, int side)
+{
+    double m = rising(s, b, side, 0.5);
+
+    /* Bodies faster than the Sun can cross twice, keep the first one */
+    if (m >= 1.0 / SIDEREAL - 0.01)
+    {
+        double e = rising(s, b, side, m - 1.0 / SIDEREAL);
+        m = (e >= 0.0) ? e : m;
+    }
+
+    /* Written so that NaN has no event either */
+    if (!(m >= 0.0 && m < 1.0))
+        return (time_t)-1;
+
+    return epoch(s->j2k + m);
+}
+
+extern void
+mona_risings(struct mona_waypoint p, uint32_t mask,
+             struct mona_rising out[MONA_OBJECT_COUNT])
+{
+    /* Local mean day, shared by every body */
+    struct sky s = {0};
+    s.latitude = p.latitude;
+    s.j2k = floor(p.j2k - 0.0008 + 0.5 + p.longitude / 360.0) +
+            0.0008 - 0.5 - p.longitude / 360.0;
+    s.tilt = tilt_earth(s.j2k + 0.5);
+    s.lst = local_sidereal(s.j2k, p.longitude);
+
+    struct mona_waypoint w[3];
+    for (int i = 0; i < 3; i++)
+        w[i] = mona_waypoint(epoch(s.j2k + i * 0.5),
+                             p.latitude, p.longitude);
+
+    for (int o = 0; o < MONA_OBJECT_COUNT; o++)
+    {
+        struct mona_rising ret = {(time_t)-1, (time_t)-1, (time_t)-1};
+
+        if (o < MONA_OBJECT_ASCENDANT && (mask & MONA_RISING_OBJECT(o)))
+        {
+            double l[3];
+            for (int i = 0; i < 3; i++)
+                l[i] = position(w[i], o);
+
+            double a = wrap(l[1] - l[0]), c = wrap(l[2] - l[1]);
+
+            struct body b = {0};
+            b.longitude = l[0];
+            b.c1 = 3.0 * a - c;
+            b.c2 = 2.0 * (c - a);
+            b.node = -1.0;
+            b.h0 = -0.5667;
+
+            if (o == MONA_OBJECT_MOON)
+            {
+                b.node = pos_north_node(w[0].T);
+                b.h0 = 0.125;
+            }
+            else if (o == MONA_OBJECT_SUN)
+            {
+                b.h0 = -0.8333;
+            }
+            else if (o == MONA_OBJECT_NORTH_NODE ||
+                     o == MONA_OBJECT_SOUTH_NODE)
+            {
+                /* Points without a disc, on the geometric horizon */
+                b.h0 = 0.0;
+            }
+
+            ret.rise = rising_time(&s, &b, -1);
+            ret.transit = rising_time(&s, &b, 0);
+            ret.set = rising_time(&s, &b, 1);
+        }
+
+        out[o] = ret;
+    }
 }
@@ -0,0 +1,578 @@
+/*
+ *  This file is part of libmona
+ *
+ *  Libmona is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  Libmona is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with libmona; if not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MONA_NO_THREADS
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <math.h>
+#include <time.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef MONA_NO_THREADS
+#include <stdlib.h>
+#include <pthread.h>
+#endif
+
+#include <mona/core.h>
+#include <mona/event.h>
+
+/* Steps taken before a search gives up, enough for centuries of Saturn */
+#define STEPS 100000
+
+/* Fastest apparent motion of each object, in degrees per day */
+static const double SPEEDS[] = {
+    [MONA_OBJECT_MOON]    = 16.0,  [MONA_OBJECT_MERCURY] = 2.5,
+    [MONA_OBJECT_VENUS]   = 1.5,   [MONA_OBJECT_SUN]     = 1.1,
+    [MONA_OBJECT_MARS]    = 1.0,   [MONA_OBJECT_JUPITER] = 0.3,
+    [MONA_OBJECT_SATURN]  = 0.15,
+
+    [MONA_OBJECT_URANUS]     = 0.08, [MONA_OBJECT_NEPTUNE]    = 0.05,
+    [MONA_OBJECT_PLUTO]      = 0.05, [MONA_OBJECT_NORTH_NODE] = 0.06,
+    [MONA_OBJECT_SOUTH_NODE] = 0.06,
+
+    [MONA_OBJECT_ASCENDANT]    = 3600.0,
+    [MONA_OBJECT_DESCENDANT]   = 3600.0,
+    [MONA_OBJECT_MEDIUM_COELI] = 400.0,
+    [MONA_OBJECT_IMUM_COELI]   = 400.0
+};
+
+struct query
+{
+    double latitude, longitude;
+    enum mona_field field;
+    enum mona_object object;
+};
+
+/* Auxiliary functions */
+
+static time_t
+utc(struct mona_waypoint p)
+{
+    double jd = p.j2k + 2451545.0 - 0.0008;
+    return (time_t)floor((jd - 2440587.5) * 86400.0 + 0.5);
+}
+
+static uint8_t
+value(const struct query *q, time_t t)
+{
+    uint8_t ret = 0;
+
+    struct mona_solar s;
+    struct mona_lunar l;
+
+    struct mona_waypoint p = mona_waypoint(t, q->latitude, q->longitude);
+    switch (q->field)
+    {
+        case MONA_FIELD_HOUR:
+            mona_solar_ex(p, MONA_SOLAR_HOUR, &s);
+            ret = s.hour;
+            break;
+        case MONA_FIELD_DAY:
+            mona_solar_ex(p, MONA_SOLAR_DAY, &s);
+            ret = s.day;
+            break;
+        case MONA_FIELD_SEASON:
+            mona_solar_ex(p, MONA_SOLAR_SEASON, &s);
+            ret = s.season;
+            break;
+        case MONA_FIELD_MOON:
+            mona_lunar_ex(p, MONA_LUNAR_PHASE, &l);
+            ret = l.phase;
+            break;
+        case MONA_FIELD_SIGN:
+            ret = mona_zodiac(p, q->object).sign;
+            break;
+        case MONA_FIELD_DECAN:
+            ret = mona_zodiac(p, q->object).decan;
+            break;
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+/* Steps guaranteed to land before the next change, or just past the
+   predicted one for the fields that have closed forms */
+
+static time_t
+closed(double seconds)
+{
+    return (seconds > 3.0) ? (time_t)(seconds - 2.0) : 4;
+}
+
+static double
+until_day(struct mona_waypoint p)
+{
+    return (floor(p.j2k) + 1.0 - p.j2k) * 86400.0;
+}
+
+static double
+until_hour(struct mona_waypoint p, time_t t)
+{
+    double ret = until_day(p);
+
+    struct mona_solar s;
+    mona_solar_ex(p, MONA_SOLAR_SUNRISE, &s);
+    double length = difftime(s.sunset, s.sunrise) / 12.0;
+    if (length > 0.0)
+    {
+        double hour = difftime(t, s.sunrise) / length;
+        double next = (floor(hour) + 1.0 - hour) * length;
+        ret = (next < ret) ? next : ret;
+    }
+
+    return ret;
+}
+
+static double
+until_season(struct mona_waypoint p)
+{
+    /* Only changes at day boundaries, about a degree per day */
+    struct mona_solar s;
+    mona_solar_ex(p, MONA_SOLAR_DEGREE, &s);
+
+    double deg = 90.0 - fmod(s.degree, 90.0);
+    return until_day(p) + floor(deg / 1.1) * 86400.0;
+}
+
+static double
+until_moon(struct mona_waypoint p)
+{
+    struct mona_lunar l;
+    mona_lunar_ex(p, MONA_LUNAR_ALL, &l);
+
+    double deg = (l.phase + 1) * 45.0 - l.degree;
+    return deg / 360.0 * difftime(l.ending, l.beginning);
+}
+
+static double
+until_boundary(struct mona_waypoint p, enum mona_object o, double width)
+{
+    double deg = fmod(mona_zodiac(p, o).position, width);
+    deg = (deg < width - deg) ? deg : width - deg;
+    return deg / SPEEDS[o] * 86400.0;
+}
+
+static time_t
+step(const struct query *q, time_t t)
+{
+    time_t ret = 1;
+
+    struct mona_waypoint p = mona_waypoint(t, q->latitude, q->longitude);
+    double seconds = 0.0;
+    switch (q->field)
+    {
+        case MONA_FIELD_HOUR:
+            ret = closed(until_hour(p, t));
+            break;
+        case MONA_FIELD_DAY:
+            ret = closed(until_day(p));
+            break;
+        case MONA_FIELD_SEASON:
+            ret = closed(until_season(p));
+            break;
+        case MONA_FIELD_MOON:
+            ret = closed(until_moon(p));
+            break;
+        case MONA_FIELD_SIGN:
+            seconds = until_boundary(p, q->object, 30.0);
+            ret = (seconds > 1.0) ? (time_t)seconds : 1;
+            break;
+        case MONA_FIELD_DECAN:
+            seconds = until_boundary(p, q->object, 10.0);
+            ret = (seconds > 1.0) ? (time_t)seconds : 1;
+            break;
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+/* Search functions */
+
+static time_t
+refine(const struct query *q, uint8_t v, time_t lo, time_t hi)
+{
+    while (hi - lo > 1)
+    {
+        time_t mid = lo + (hi - lo) / 2;
+        if (value(q, mid) == v)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    return hi;
+}
+
+static time_t
+next(const struct query *q, time_t t, uint8_t v, time_t end)
+{
+    for (int i = 0; i < STEPS && (end == -1 || t < end); i++)
+    {
+        time_t hi = t + step(q, t);
+        if (end != -1 && hi > end)
+            hi = end;
+
+        if (value(q, hi) != v)
+            return refine(q, v, t, hi);
+        t = hi;
+    }
+
+    return -1;
+}
+
+extern time_t
+mona_next_change(struct mona_waypoint p, uint32_t mask,
+                 struct mona_event *event)
+{
+    time_t ret = -1;
+
+    time_t t = utc(p);
+    struct query q = {.latitude = p.latitude, .longitude = p.longitude};
+
+    for (int f = 0; f < MONA_FIELD_COUNT; f++)
+    {
+        if (!(mask & MONA_CHANGE_FIELD(f)))
+            continue;
+
+        int objects = 1;
+        if (f == MONA_FIELD_SIGN || f == MONA_FIELD_DECAN)
+            objects = MONA_OBJECT_COUNT;
+
+        for (int o = 0; o < objects; o++)
+        {
+            if (objects > 1 && (!(mask & MONA_CHANGE_OBJECT(o)) ||
+                                !mona_object_available(o)))
+                continue;
+
+            q.field = f;
+            q.object = o;
+
+            uint8_t v = value(&q, t);
+            time_t n = next(&q, t, v, -1);
+            if (n != -1 && (ret == -1 || n < ret))
+            {
+                ret = n;
+                if (event)
+                {
+                    event->time = n;
+                    event->field = f;
+                    event->object = o;
+                    event->from = v;
+                    event->to = value(&q, n);
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+/* Election search */
+
+struct election
+{
+    const struct mona_predicate *order[MONA_PREDICATES];
+    size_t count;
+    double latitude, longitude;
+
+    struct mona_interval *out, last;
+    size_t max, found;
+};
+
+static double
+cost(const struct mona_predicate *p)
+{
+    /* Expected changes per day, times evaluations per change */
+    double ret = 0.0;
+
+    switch (p->field)
+    {
+        case MONA_FIELD_HOUR:
+            ret = 24.0 * 4.0;
+            break;
+        case MONA_FIELD_DAY:
+            ret = 1.0 * 4.0;
+            break;
+        case MONA_FIELD_SEASON:
+            ret = (4.0 / 365.25) * 4.0;
+            break;
+        case MONA_FIELD_MOON:
+            ret = (8.0 / 29.53) * 4.0;
+            break;
+        case MONA_FIELD_SIGN:
+            ret = SPEEDS[p->object] / 30.0 * 32.0;
+            break;
+        case MONA_FIELD_DECAN:
+            ret = SPEEDS[p->object] / 10.0 * 32.0;
+            break;
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+static void
+emit(struct election *e, time_t beginning, time_t ending)
+{
+    if (e->found > 0 && e->last.ending == beginning)
+        e->last.ending = ending;
+    else
+    {
+        e->found++;
+        e->last.beginning = beginning;
+        e->last.ending = ending;
+    }
+
+    if (e->found <= e->max)
+        e->out[e->found - 1] = e->last;
+}
+
+static void
+walk(struct election *e, size_t level, time_t beginning, time_t ending)
+{
+    if (level == e->count)
+    {
+        emit(e, beginning, ending);
+        return;
+    }
+
+    const struct mona_predicate *p = e->order[level];
+    struct query q = {.latitude = e->latitude, .longitude = e->longitude,
+                      .field = p->field, .object = p->object};
+
+    time_t t = beginning;
+    uint8_t v = value(&q, t);
+    while (t < ending)
+    {
+        time_t n = next(&q, t, v, ending);
+        if (n == -1)
+            n = ending;
+
+        /* Only the windows that pass are searched for the next predicate */
+        if (p->values & MONA_VALUE(v))
+            walk(e, level + 1, t, n);
+
+        t = n;
+        if (t < ending)
+            v = value(&q, t);
+    }
+}
+
+extern size_t
+mona_election(const struct mona_predicate *predicates, size_t count,
+              double latitude, double longitude,
+              time_t beginning, time_t ending,
+              struct mona_interval *out, size_t max)
+{
+    struct election e = {.count = count, .latitude = latitude,
+                         .longitude = longitude, .out = out, .max = max};
+
+    if (count > MONA_PREDICATES || beginning >= ending)
+        return (size_t)-1;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (predicates[i].field >= MONA_FIELD_COUNT ||
+            !mona_object_available(predicates[i].object))
+            return (size_t)-1;
+    }
+
+    /* Cheapest first, insertion sort is enough for a few predicates */
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t j = i;
+        for (; j > 0 && cost(e.order[j - 1]) > cost(&(predicates[i])); j--)
+            e.order[j] = e.order[j - 1];
+        e.order[j] = &(predicates[i]);
+    }
+
+    walk(&e, 0, beginning, ending);
+
+    return e.found;
+}
+
+/*  Statistics, occupancy is summed between changes so it is exact to the
+    second, the range is split in chunks that may run on their own threads */
+
+struct chunk
+{
+    const struct mona_statistics *stats;
+    size_t count;
+    double latitude, longitude;
+    time_t beginning, ending;
+
+    struct mona_statistics *out;
+    uint8_t first[MONA_STATISTICS], last[MONA_STATISTICS];
+    int threaded;
+};
+
+static void
+gather(struct chunk *c)
+{
+    for (size_t i = 0; i < c->count; i++)
+    {
+        /* Output may be the input itself */
+        struct query q = {.latitude = c->latitude, .longitude = c->longitude,
+                          .field = c->stats[i].field,
+                          .object = c->stats[i].object};
+
+        struct mona_statistics *s = &(c->out[i]);
+        memset(s, 0, sizeof(*s));
+        s->field = q.field;
+        s->object = q.object;
+
+        time_t t = c->beginning;
+        uint8_t v = value(&q, t);
+        c->first[i] = v;
+        while (t < c->ending)
+        {
+            time_t n = next(&q, t, v, c->ending);
+            if (n == -1)
+                n = c->ending;
+
+            s->seconds[v] += n - t;
+            s->entries[v]++;
+            c->last[i] = v;
+
+            t = n;
+            if (t < c->ending)
+                v = value(&q, t);
+        }
+    }
+}
+
+#ifndef MONA_NO_THREADS
+static void *
+worker(void *arg)
+{
+    gather(arg);
+    return NULL;
+}
+
+static int
+scatter(struct mona_statistics *stats, size_t count,
+        double latitude, double longitude,
+        time_t beginning, time_t ending, unsigned threads)
+{
+    struct chunk *chunks = calloc(threads, sizeof(struct chunk));
+    struct mona_statistics *outs = calloc(threads * count,
+                                          sizeof(struct mona_statistics));
+    pthread_t *ids = calloc(threads, sizeof(pthread_t));
+
+    if (!chunks || !outs || !ids)
+    {
+        free(chunks);
+        free(outs);
+        free(ids);
+        return -1;
+    }
+
+    time_t length = ending - beginning;
+    for (unsigned k = 0; k < threads; k++)
+    {
+        struct chunk *c = &(chunks[k]);
+        c->stats = stats;
+        c->count = count;
+        c->latitude = latitude;
+        c->longitude = longitude;
+        c->beginning = beginning + length / threads * k;
+        c->ending = (k + 1 < threads) ?
+                    beginning + length / threads * (k + 1) : ending;
+        c->out = &(outs[count * k]);
+    }
+
+    /* Chunks whose thread could not start are gathered here instead */
+    for (unsigned k = 1; k < threads; k++)
+        chunks[k].threaded = !pthread_create(&(ids[k]), NULL, worker,
+                                             &(chunks[k]));
+    for (unsigned k = 0; k < threads; k++)
+    {
+        if (chunks[k].threaded)
+            pthread_join(ids[k], NULL);
+        else
+            gather(&(chunks[k]));
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        struct mona_statistics *s = &(stats[i]);
+        memset(s->seconds, 0, sizeof(s->seconds));
+        memset(s->entries, 0, sizeof(s->entries));
+
+        for (unsigned k = 0; k < threads; k++)
+        {
+            const struct chunk *c = &(chunks[k]);
+            for (int v = 0; v < MONA_STATISTICS_VALUES; v++)
+            {
+                s->seconds[v] += c->out[i].seconds[v];
+                s->entries[v] += c->out[i].entries[v];
+            }
+
+            /* A run going on into the next chunk was entered only once */
+            if (k > 0 && chunks[k - 1].last[i] == c->first[i])
+                s->entries[c->first[i]]--;
+        }
+    }
+
+    free(chunks);
+    free(outs);
+    free(ids);
+    return 0;
+}
+#endif
+
+extern int
+mona_statistics(struct mona_statistics *stats, size_t count,
+                double latitude, double longitude,
+                time_t beginning, time_t ending, unsigned threads)
+{
+    if (count > MONA_STATISTICS || beginning >= ending)
+        return -1;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (stats[i].field >= MONA_FIELD_COUNT ||
+            !mona_object_available(stats[i].object))
+            return -1;
+    }
+
+    /* Chunks shorter than a day are not worth a thread */
+    time_t days = (ending - beginning) / 86400;
+    if (threads > days)
+        threads = days;
+
+    #ifndef MONA_NO_THREADS
+    if (threads > 1)
+        return scatter(stats, count, latitude, longitude,
+                       beginning, ending, threads);
+    #endif
+
+    struct chunk c = {.stats = stats, .count = count,
+                      .latitude = latitude, .longitude = longitude,
+                      .beginning = beginning, .ending = ending, .out = stats};
+    gather(&c);
+
+    return 0;
+}
@@ -0,0 +1,609 @@
+/*
+ *  This file is part of libmona
+ *
+ *  Libmona is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  Libmona is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with libmona; if not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <mona/core.h>
+#include <mona/string.h>
+
+/*  Bulk ephemeris generator
+
+    Records are read or generated in blocks by a reader thread, computed
+    by the workers and written in order by the main thread. CSV has a
+    header line, the binary format is one record after another in host
+    byte order:
+        int64_t utc, double latitude, double longitude,
+        uint32_t angle for each object, where 2^32 is a full turn */
+
+enum state
+{
+    STATE_FREE,
+    STATE_PENDING,
+    STATE_BUSY,
+    STATE_DONE
+};
+
+struct location
+{
+    double latitude, longitude;
+};
+
+struct block
+{
+    enum state state;
+    size_t id, count;
+
+    time_t *times;
+    struct location *locations;
+
+    char *output;
+    size_t length;
+};
+
+static struct
+{
+    uint8_t binary;
+    size_t size;
+
+    enum mona_object objects[MONA_OBJECT_COUNT];
+    size_t nobjects;
+
+    struct block *blocks;
+    size_t nblocks;
+
+    size_t queued, written;
+    uint8_t eof, quit;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work, done, space;
+} cli = {.size = 1024,
+         .lock  = PTHREAD_MUTEX_INITIALIZER,
+         .work  = PTHREAD_COND_INITIALIZER,
+         .done  = PTHREAD_COND_INITIALIZER,
+         .space = PTHREAD_COND_INITIALIZER};
+
+/* Auxiliary functions */
+
+static void
+usage(void)
+{
+    fprintf(stderr,
+            "Usage: mona [options]\n"
+            "  -f UTC        first time of the range, in seconds\n"
+            "  -t UTC        end of the range, exclusive\n"
+            "  -s SECONDS    step of the range, 3600 by default\n"
+            "  -l LAT,LON    location, can be repeated, 0,0 by default\n"
+            "  -o OBJECTS    comma separated object names, or all\n"
+            "  -b            binary records instead of CSV\n"
+            "  -j THREADS    worker threads, online processors by default\n"
+            "  -n RECORDS    records per block, 1024 by default\n"
+            "  -i            read \"utc latitude longitude\" from stdin, a block\n"
+            "                is written as soon as no more input is ready\n");
+}
+
+static uint8_t
+same(const char *a, size_t length, const char *name)
+{
+    size_t i = 0;
+    for (; i < length && name[i]; i++)
+    {
+        char c = (a[i] == '_' || a[i] == '-') ? ' ' : a[i];
+        if (tolower((unsigned char)c) != tolower((unsigned char)name[i]))
+            return 0;
+    }
+
+    return i == length && name[i] == '\0';
+}
+
+static uint8_t
+objects(const char *arg)
+{
+    cli.nobjects = 0;
+
+    while (*arg)
+    {
+        size_t length = strcspn(arg, ",");
+
+        uint8_t found = 0;
+        for (int o = 0; o < MONA_OBJECT_COUNT; o++)
+        {
+            uint8_t all = same(arg, length, "all");
+            if (all || same(arg, length, mona_string(MONA_STRING_OBJECT, o)))
+            {
+                if (cli.nobjects < MONA_OBJECT_COUNT)
+                    cli.objects[cli.nobjects++] = o;
+                found = 1;
+            }
+        }
+
+        if (!found)
+            return 0;
+
+        arg += length;
+        arg += (*arg == ',');
+    }
+
+    return cli.nobjects > 0;
+}
+
+static uint8_t
+valid(struct location l)
+{
+    /* Written so that NaN fails as well */
+    return l.latitude >= -90.0 && l.latitude <= 90.0 &&
+           l.longitude >= -180.0 && l.longitude <= 180.0;
+}
+
+/* Record formatting */
+
+static size_t
+advance(size_t length, size_t size, int written)
+{
+    /* A truncated record stops at the capacity instead of past it */
+    if (written < 0)
+        return length;
+    return ((size_t)written < size - length) ? length + written : size;
+}
+
+static size_t
+record(char *out, size_t size, time_t utc, struct location l)
+{
+    size_t ret = 0;
+
+    struct mona_waypoint p = mona_waypoint(utc, l.latitude, l.longitude);
+    if (cli.binary)
+    {
+        int64_t t = utc;
+        memcpy(&(out[ret]), &t, sizeof(t));
+        ret += sizeof(t);
+        memcpy(&(out[ret]), &(l.latitude), sizeof(double));
+        ret += sizeof(double);
+        memcpy(&(out[ret]), &(l.longitude), sizeof(double));
+        ret += sizeof(double);
+
+        for (size_t i = 0; i < cli.nobjects; i++)
+        {
+            uint32_t a = mona_angle(p, cli.objects[i]);
+            memcpy(&(out[ret]), &a, sizeof(a));
+            ret += sizeof(a);
+        }
+    }
+    else
+    {
+        ret = advance(ret, size,
+                      snprintf(&(out[ret]), size - ret, "%lld,%.6f,%.6f",
+                               (long long)utc, l.latitude, l.longitude));
+
+        for (size_t i = 0; i < cli.nobjects; i++)
+        {
+            struct mona_zodiac z = mona_zodiac(p, cli.objects[i]);
+            ret = advance(ret, size,
+                          snprintf(&(out[ret]), size - ret, ",%.6f",
+                                   z.position));
+        }
+
+        if (ret < size)
+            out[ret++] = '\n';
+    }
+
+    return ret;
+}
+
+static size_t
+record_size(void)
+{
+    if (cli.binary)
+        return sizeof(int64_t) + 2 * sizeof(double) +
+               cli.nobjects * sizeof(uint32_t);
+
+    /* "-9223372036854775808,-90.000000,-180.000000" then ",359.999999"
+       for each object, the newline and the terminator of snprintf */
+    return 20 + 11 + 12 + cli.nobjects * 11 + 2;
+}
+
+/* Workers */
+
+static void *
+worker(void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&(cli.lock));
+    while (1)
+    {
+        struct block *b = NULL;
+        for (size_t i = 0; !b && i < cli.nblocks; i++)
+        {
+            if (cli.blocks[i].state == STATE_PENDING)
+                b = &(cli.blocks[i]);
+        }
+
+        if (!b)
+        {
+            if (cli.quit)
+                break;
+            pthread_cond_wait(&(cli.work), &(cli.lock));
+            continue;
+        }
+
+        b->state = STATE_BUSY;
+        pthread_mutex_unlock(&(cli.lock));
+
+        size_t size = cli.size * record_size();
+
+        b->length = 0;
+        for (size_t i = 0; i < b->count; i++)
+            b->length += record(&(b->output[b->length]), size - b->length,
+                                b->times[i], b->locations[i]);
+
+        pthread_mutex_lock(&(cli.lock));
+        b->state = STATE_DONE;
+        pthread_cond_broadcast(&(cli.done));
+    }
+    pthread_mutex_unlock(&(cli.lock));
+
+    return NULL;
+}
+
+/* Inputs */
+
+struct input
+{
+    uint8_t piped, eof;
+    char *buffer;
+    size_t capacity, start, end, lines;
+
+    time_t from, to, step, next;
+    struct location *locations;
+    size_t nlocations, location;
+};
+
+/* Next line of stdin, read straight from the descriptor so that poll()
+   sees everything still pending. Unless wait is set, NULL is returned
+   as soon as no complete line is ready */
+static char *
+line(struct input *in, uint8_t wait)
+{
+    while (1)
+    {
+        size_t pending = in->end - in->start;
+        char *ret = in->buffer + in->start;
+        char *end = pending ? memchr(ret, '\n', pending) : NULL;
+        if (end || (in->eof && pending))
+        {
+            end = end ? end : in->buffer + in->end;
+            *end = '\0';
+            in->start = end - in->buffer + (end < in->buffer + in->end);
+            return ret;
+        }
+        if (in->eof)
+            return NULL;
+
+        struct pollfd fd = {.fd = STDIN_FILENO, .events = POLLIN};
+        if (!wait && poll(&fd, 1, 0) == 0)
+            return NULL;
+
+        if (pending)
+            memmove(in->buffer, ret, pending);
+        in->end = pending;
+        in->start = 0;
+        if (in->end + 1 >= in->capacity)
+        {
+            size_t capacity = in->capacity ? in->capacity * 2 : 65536;
+            char *buffer = realloc(in->buffer, capacity);
+            if (!buffer)
+            {
+                perror("mona");
+                in->eof = 1;
+                continue;
+            }
+            in->buffer = buffer;
+            in->capacity = capacity;
+        }
+
+        ssize_t n = read(STDIN_FILENO, in->buffer + in->end,
+                         in->capacity - in->end - 1);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            perror("mona");
+        if (n <= 0)
+            in->eof = 1;
+        else
+            in->end += n;
+    }
+}
+
+/* A piped block is handed on once stdin runs dry, interactive use
+   gets its answers without waiting for a full block */
+static size_t
+fill(struct input *in, struct block *b)
+{
+    size_t ret = 0;
+
+    while (ret < cli.size)
+    {
+        if (in->piped)
+        {
+            char *s = line(in, ret == 0);
+            if (!s)
+                break;
+            in->lines++;
+
+            /* Bad lines are reported and skipped, the stream goes on */
+            long long utc;
+            struct location l;
+            char end;
+            int n = sscanf(s, "%lld %lf %lf %c", &utc, &(l.latitude),
+                                                        &(l.longitude), &end);
+            if (n == EOF)
+                continue;
+            if (n != 3)
+            {
+                fprintf(stderr, "mona: line %zu: expected "
+                                "\"utc latitude longitude\"\n", in->lines);
+                continue;
+            }
+            if (!valid(l))
+            {
+                fprintf(stderr, "mona: line %zu: location out of range\n",
+                        in->lines);
+                continue;
+            }
+
+            b->times[ret] = utc;
+            b->locations[ret] = l;
+        }
+        else
+        {
+            if (in->next >= in->to)
+            {
+                in->eof = 1;
+                break;
+            }
+
+            b->times[ret] = in->next;
+            b->locations[ret] = in->locations[in->location];
+
+            if (++(in->location) >= in->nlocations)
+            {
+                in->location = 0;
+                in->next += in->step;
+            }
+        }
+
+        ret++;
+    }
+
+    return ret;
+}
+
+static void *
+reader(void *arg)
+{
+    struct input *in = arg;
+
+    pthread_mutex_lock(&(cli.lock));
+    while (!cli.eof && !cli.quit)
+    {
+        while (cli.queued - cli.written >= cli.nblocks && !cli.quit)
+            pthread_cond_wait(&(cli.space), &(cli.lock));
+        if (cli.quit)
+            break;
+
+        struct block *b = &(cli.blocks[cli.queued % cli.nblocks]);
+
+        pthread_mutex_unlock(&(cli.lock));
+        size_t count = fill(in, b);
+        pthread_mutex_lock(&(cli.lock));
+
+        if (count > 0)
+        {
+            b->id = cli.queued++;
+            b->count = count;
+            b->state = STATE_PENDING;
+            pthread_cond_signal(&(cli.work));
+        }
+
+        cli.eof = in->eof;
+        pthread_cond_broadcast(&(cli.done));
+    }
+    pthread_mutex_unlock(&(cli.lock));
+
+    return NULL;
+}
+
+extern int
+main(int argc, char *argv[])
+{
+    struct input in = {.step = 3600};
+    uint8_t range = 0;
+
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    objects("all");
+
+    int opt;
+    while ((opt = getopt(argc, argv, "f:t:s:l:o:bj:n:ih")) != -1)
+    {
+        struct location l;
+        switch (opt)
+        {
+            case 'f':
+                in.from = strtoll(optarg, NULL, 10);
+                range |= 1;
+                break;
+            case 't':
+                in.to = strtoll(optarg, NULL, 10);
+                range |= 2;
+                break;
+            case 's':
+                in.step = strtoll(optarg, NULL, 10);
+                break;
+            case 'l':
+                if (sscanf(optarg, "%lf,%lf", &(l.latitude),
+                                              &(l.longitude)) != 2)
+                {
+                    usage();
+                    return 1;
+                }
+                if (!valid(l))
+                {
+                    fprintf(stderr, "mona: location out of range in %s\n",
+                            optarg);
+                    return 1;
+                }
+                in.locations = realloc(in.locations, (in.nlocations + 1) *
+                                                     sizeof(l));
+                if (!in.locations)
+                {
+                    perror("mona");
+                    return 1;
+                }
+                in.locations[in.nlocations++] = l;
+                break;
+            case 'o':
+                if (!objects(optarg))
+                {
+                    fprintf(stderr, "mona: unknown object in %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'b':
+                cli.binary = 1;
+                break;
+            case 'j':
+                threads = strtol(optarg, NULL, 10);
+                break;
+            case 'n':
+                cli.size = strtoul(optarg, NULL, 10);
+                break;
+            case 'i':
+                in.piped = 1;
+                break;
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if ((!in.piped && range != 3) || in.step <= 0 ||
+        threads <= 0 || cli.size == 0 || cli.size > SIZE_MAX / record_size())
+    {
+        usage();
+        return 1;
+    }
+
+    static struct location origin = {0};
+    if (in.nlocations == 0)
+    {
+        in.locations = &origin;
+        in.nlocations = 1;
+    }
+    in.next = in.from;
+
+    /* Two blocks per worker keep them busy while the output is written */
+    cli.nblocks = threads * 2;
+    cli.blocks = calloc(cli.nblocks, sizeof(struct block));
+    pthread_t *workers = calloc(threads, sizeof(pthread_t));
+    if (!cli.blocks || !workers)
+    {
+        perror("mona");
+        return 1;
+    }
+
+    for (size_t i = 0; i < cli.nblocks; i++)
+    {
+        struct block *b = &(cli.blocks[i]);
+        b->times = malloc(cli.size * sizeof(time_t));
+        b->locations = malloc(cli.size * sizeof(struct location));
+        b->output = malloc(cli.size * record_size());
+        if (!b->times || !b->locations || !b->output)
+        {
+            perror("mona");
+            return 1;
+        }
+    }
+
+    if (!cli.binary)
+    {
+        printf("utc,latitude,longitude");
+        for (size_t i = 0; i < cli.nobjects; i++)
+            printf(",%s", mona_string(MONA_STRING_OBJECT, cli.objects[i]));
+        printf("\n");
+    }
+
+    for (long i = 0; i < threads; i++)
+        pthread_create(&(workers[i]), NULL, worker, NULL);
+
+    pthread_t input;
+    pthread_create(&input, NULL, reader, &in);
+
+    int ret = 0;
+    pthread_mutex_lock(&(cli.lock));
+    while (1)
+    {
+        struct block *b = &(cli.blocks[cli.written % cli.nblocks]);
+        while (!(cli.written < cli.queued && b->state == STATE_DONE) &&
+               !(cli.eof && cli.written == cli.queued))
+            pthread_cond_wait(&(cli.done), &(cli.lock));
+
+        if (cli.written == cli.queued)
+            break;
+
+        pthread_mutex_unlock(&(cli.lock));
+        if (fwrite(b->output, 1, b->length, stdout) != b->length)
+            ret = 1;
+        if (in.piped)
+            fflush(stdout);
+        pthread_mutex_lock(&(cli.lock));
+
+        b->state = STATE_FREE;
+        cli.written++;
+        pthread_cond_signal(&(cli.space));
+
+        if (ret)
+            break;
+    }
+
+    cli.quit = 1;
+    pthread_cond_broadcast(&(cli.work));
+    pthread_cond_broadcast(&(cli.space));
+    pthread_mutex_unlock(&(cli.lock));
+
+    pthread_join(input, NULL);
+    for (long i = 0; i < threads; i++)
+        pthread_join(workers[i], NULL);
+
+    if (fflush(stdout) != 0)
+        ret = 1;
+
+    free(in.buffer);
+    free(workers);
+    if (in.locations != &origin)
+        free(in.locations);
+    return ret;
+}
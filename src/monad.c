@@ -0,0 +1,452 @@
+/*
+ *  This file is part of libmona
+ *
+ *  Libmona is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  Libmona is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with libmona; if not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <mona/core.h>
+#include <mona/client.h>
+
+/*  Chart daemon
+
+    Requests and responses are fixed size records, answered in order on
+    each connection, so clients can pipeline them. Charts are kept in a
+    direct mapped cache keyed by the quantized time and location, which
+    makes concurrent requests for the same chart share one computation */
+
+#define EVENTS    64
+#define REQUESTS  256
+#define RESPONSES 256
+
+struct chart
+{
+    uint8_t valid;
+    int64_t utc, latitude, longitude;
+
+    struct mona_waypoint waypoint;
+
+    uint32_t objects;
+    struct mona_zodiac zodiac[MONA_OBJECT_COUNT];
+
+    uint8_t lunar_valid, solar_valid;
+    struct mona_lunar lunar;
+    struct mona_solar solar;
+};
+
+struct connection
+{
+    int fd;
+    uint32_t events;
+    uint8_t closing;
+
+    uint8_t in[REQUESTS * sizeof(struct mona_request)];
+    size_t inlen;
+
+    uint8_t out[RESPONSES * sizeof(struct mona_response)];
+    size_t outpos, outlen;
+};
+
+static struct
+{
+    int epoll;
+    int64_t quantum;
+
+    struct chart *cache;
+    size_t entries;
+} server = {.quantum = 1, .entries = 4096};
+
+/* Requests */
+
+static int
+valid(const struct mona_request *r)
+{
+    /* Checked before chart() so a bad request never evicts a chart */
+    if (!(r->latitude >= -90.0 && r->latitude <= 90.0) ||
+        !(r->longitude >= -180.0 && r->longitude <= 180.0))
+        return 0;
+
+    switch (r->query)
+    {
+        case MONA_QUERY_WAYPOINT:
+        case MONA_QUERY_LUNAR:
+        case MONA_QUERY_SOLAR:
+            return 1;
+        case MONA_QUERY_ZODIAC:
+            return mona_object_available(r->object);
+        default:
+            return 0;
+    }
+}
+
+/* Chart cache */
+
+static struct chart *
+chart(const struct mona_request *r)
+{
+    int64_t utc = r->utc - (((r->utc % server.quantum) + server.quantum) %
+                            server.quantum);
+    int64_t latitude = llround(r->latitude * 1E6);
+    int64_t longitude = llround(r->longitude * 1E6);
+
+    uint64_t h = (uint64_t)utc * 0x9E3779B97F4A7C15u;
+    h ^= (uint64_t)latitude * 0xC2B2AE3D27D4EB4Fu;
+    h ^= (uint64_t)longitude * 0x165667B19E3779F9u;
+    h ^= h >> 29;
+
+    struct chart *ret = &(server.cache[h % server.entries]);
+    if (ret->valid && ret->utc == utc &&
+        ret->latitude == latitude && ret->longitude == longitude)
+        return ret;
+
+    memset(ret, 0, sizeof(*ret));
+    ret->valid = 1;
+    ret->utc = utc;
+    ret->latitude = latitude;
+    ret->longitude = longitude;
+    ret->waypoint = mona_waypoint(utc, latitude / 1E6, longitude / 1E6);
+
+    return ret;
+}
+
+static void
+answer(const struct mona_request *r, struct mona_response *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->id = r->id;
+    out->query = r->query;
+    out->status = MONA_STATUS_OK;
+
+    if (!valid(r))
+    {
+        out->status = MONA_STATUS_INVALID;
+        return;
+    }
+
+    struct chart *c = chart(r);
+    switch (r->query)
+    {
+        case MONA_QUERY_WAYPOINT:
+            out->data.waypoint = c->waypoint;
+            break;
+
+        case MONA_QUERY_ZODIAC:
+            if (!(c->objects & (UINT32_C(1) << r->object)))
+            {
+                c->zodiac[r->object] = mona_zodiac(c->waypoint, r->object);
+                c->objects |= UINT32_C(1) << r->object;
+            }
+            out->data.zodiac = c->zodiac[r->object];
+            break;
+
+        case MONA_QUERY_LUNAR:
+            if (!c->lunar_valid)
+            {
+                c->lunar = mona_lunar(c->waypoint);
+                c->lunar_valid = 1;
+            }
+            out->data.lunar = c->lunar;
+            break;
+
+        case MONA_QUERY_SOLAR:
+            if (!c->solar_valid)
+            {
+                c->solar = mona_solar(c->waypoint);
+                c->solar_valid = 1;
+            }
+            out->data.solar = c->solar;
+            break;
+    }
+}
+
+/* Connections */
+
+static void
+drop(struct connection *c)
+{
+    epoll_ctl(server.epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    free(c);
+}
+
+static void
+watch(struct connection *c)
+{
+    /* Stop reading while the responses are not drained */
+    uint32_t events = 0;
+    if (c->inlen < sizeof(c->in) && !c->closing)
+        events |= EPOLLIN;
+    if (c->outlen > c->outpos)
+        events |= EPOLLOUT;
+
+    if (events != c->events)
+    {
+        struct epoll_event e = {.events = events, .data.ptr = c};
+        epoll_ctl(server.epoll, EPOLL_CTL_MOD, c->fd, &e);
+        c->events = events;
+    }
+}
+
+static void
+process(struct connection *c)
+{
+    /* Written responses make room, then every complete request that fits
+       in the output is answered */
+    memmove(c->out, &(c->out[c->outpos]), c->outlen - c->outpos);
+    c->outlen -= c->outpos;
+    c->outpos = 0;
+
+    size_t done = 0;
+    while (c->inlen - done >= sizeof(struct mona_request) &&
+           sizeof(c->out) - c->outlen >= sizeof(struct mona_response))
+    {
+        struct mona_request r;
+        memcpy(&r, &(c->in[done]), sizeof(r));
+
+        struct mona_response res;
+        answer(&r, &res);
+        memcpy(&(c->out[c->outlen]), &res, sizeof(res));
+
+        done += sizeof(r);
+        c->outlen += sizeof(res);
+    }
+
+    memmove(c->in, &(c->in[done]), c->inlen - done);
+    c->inlen -= done;
+}
+
+static int
+flush(struct connection *c)
+{
+    while (c->outpos < c->outlen)
+    {
+        ssize_t n = write(c->fd, &(c->out[c->outpos]), c->outlen - c->outpos);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (n <= 0)
+            return -1;
+        c->outpos += n;
+    }
+
+    return 0;
+}
+
+static int
+receive(struct connection *c)
+{
+    while (c->inlen < sizeof(c->in))
+    {
+        ssize_t n = read(c->fd, &(c->in[c->inlen]), sizeof(c->in) - c->inlen);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (n < 0)
+            return -1;
+
+        /* Half closed clients still get the pending responses */
+        if (n == 0)
+        {
+            c->closing = 1;
+            break;
+        }
+        c->inlen += n;
+
+        process(c);
+    }
+
+    return 0;
+}
+
+static void
+accept_all(int listener)
+{
+    while (1)
+    {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0)
+            break;
+
+        struct connection *c = malloc(sizeof(struct connection));
+        if (!c)
+        {
+            close(fd);
+            continue;
+        }
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        c->fd = fd;
+        c->events = EPOLLIN;
+        c->closing = 0;
+        c->inlen = c->outpos = c->outlen = 0;
+
+        struct epoll_event e = {.events = EPOLLIN, .data.ptr = c};
+        if (epoll_ctl(server.epoll, EPOLL_CTL_ADD, fd, &e) < 0)
+        {
+            close(fd);
+            free(c);
+        }
+    }
+}
+
+static void
+usage(void)
+{
+    fprintf(stderr,
+            "Usage: monad [options]\n"
+            "  -s PATH       socket path, " MONA_SOCKET " by default\n"
+            "  -q SECONDS    time quantum of the cache, 1 by default\n"
+            "  -c ENTRIES    charts kept in the cache, 4096 by default\n");
+}
+
+extern int
+main(int argc, char *argv[])
+{
+    const char *path = MONA_SOCKET;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:q:c:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                path = optarg;
+                break;
+            case 'q':
+                server.quantum = strtoll(optarg, NULL, 10);
+                break;
+            case 'c':
+                server.entries = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (server.quantum <= 0 || server.entries == 0 ||
+        strlen(path) >= sizeof(addr.sun_path))
+    {
+        usage();
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+
+    server.cache = calloc(server.entries, sizeof(struct chart));
+    if (!server.cache)
+    {
+        perror("monad");
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    /* Only a stale socket is replaced, never another kind of file */
+    struct stat st;
+    if (lstat(path, &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
+        {
+            fprintf(stderr, "monad: %s exists and is not a socket\n", path);
+            return 1;
+        }
+        unlink(path);
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 ||
+        bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(listener, SOMAXCONN) < 0)
+    {
+        perror("monad");
+        return 1;
+    }
+    fcntl(listener, F_SETFL, fcntl(listener, F_GETFL) | O_NONBLOCK);
+
+    server.epoll = epoll_create1(0);
+    struct epoll_event e = {.events = EPOLLIN, .data.ptr = NULL};
+    if (server.epoll < 0 ||
+        epoll_ctl(server.epoll, EPOLL_CTL_ADD, listener, &e) < 0)
+    {
+        perror("monad");
+        return 1;
+    }
+
+    struct epoll_event events[EVENTS];
+    while (1)
+    {
+        int n = epoll_wait(server.epoll, events, EVENTS, -1);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+        {
+            perror("monad");
+            return 1;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            struct connection *c = events[i].data.ptr;
+            if (!c)
+            {
+                accept_all(listener);
+                continue;
+            }
+
+            int err = 0;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                err = receive(c);
+
+            /* Requests left behind a full output go after each flush, until
+               neither the input nor the output moves */
+            while (!err)
+            {
+                size_t before = c->inlen;
+                process(c);
+                err = flush(c);
+                if (c->inlen == before && c->outpos == 0)
+                    break;
+            }
+
+            if (c->closing && c->outpos == c->outlen &&
+                c->inlen < sizeof(struct mona_request))
+                err = -1;
+
+            if (err)
+                drop(c);
+            else
+                watch(c);
+        }
+    }
+
+    return 0;
+}
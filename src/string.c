@@ -20,7 +20,7 @@
 #include <mona/core.h>
 #include <mona/string.h>
 
-static const char *SIGNS[] = {
+static const char *const SIGNS[] = {
     [MONA_SIGN_ARIES]       = "Aries",
     [MONA_SIGN_TAURUS]      = "Taurus",
     [MONA_SIGN_GEMINI]      = "Gemini",
@@ -35,32 +35,32 @@ static const char *SIGNS[] = {
     [MONA_SIGN_PISCES]      = "Pisces",
 };
 
-static const char *DECANS[] = {
+static const char *const DECANS[] = {
     [MONA_DECAN_ASCENDANT] = "Ascendant",
     [MONA_DECAN_SUCCEDENT] = "Succedent",
     [MONA_DECAN_CADENT]    = "Cadent"
 };
 
-static const char *DAYS[] = {
+static const char *const DAYS[] = {
     [MONA_DAY_SUN]  =    "Sun",     [MONA_DAY_MOON] =    "Moon",
     [MONA_DAY_MARS] =    "Mars",    [MONA_DAY_MERCURY] = "Mercury",
     [MONA_DAY_JUPITER] = "Jupiter", [MONA_DAY_VENUS]   = "Venus",
     [MONA_DAY_SATURN]  = "Saturn"
 };
 
-static const char *HOURS[] = {
+static const char *const HOURS[] = {
     [MONA_HOUR_SUN]  =    "Sun",     [MONA_HOUR_MOON] =    "Moon",
     [MONA_HOUR_MARS] =    "Mars",    [MONA_HOUR_MERCURY] = "Mercury",
     [MONA_HOUR_JUPITER] = "Jupiter", [MONA_HOUR_VENUS]   = "Venus",
     [MONA_HOUR_SATURN]  = "Saturn"
 };
 
-static const char *SEASONS[] = {
+static const char *const SEASONS[] = {
     [MONA_SEASON_SUMMER] = "Summer", [MONA_SEASON_AUTUMN] = "Autumn",
     [MONA_SEASON_WINTER] = "Winter", [MONA_SEASON_SPRING] = "Spring"
 };
 
-static const char *MOONS[] = {
+static const char *const MOONS[] = {
     [MONA_MOON_NEW]             = "New Moon",
     [MONA_MOON_WAXING_CRESCENT] = "Waxing Crescent",
     [MONA_MOON_FIRST_QUARTER]   = "First Quarter",
@@ -71,12 +71,17 @@ static const char *MOONS[] = {
     [MONA_MOON_WANING_CRESCENT] = "Waning Crescent"
 };
 
-static const char *OBJECTS[] = {
+static const char *const OBJECTS[] = {
     [MONA_OBJECT_MOON]    = "Moon",  [MONA_OBJECT_MERCURY] = "Mercury",
     [MONA_OBJECT_VENUS]   = "Venus", [MONA_OBJECT_SUN]     = "Sun",
     [MONA_OBJECT_MARS]    = "Mars",  [MONA_OBJECT_JUPITER] = "Jupiter",
     [MONA_OBJECT_SATURN]  = "Saturn",
 
+    [MONA_OBJECT_URANUS]     = "Uranus",     [MONA_OBJECT_NEPTUNE] = "Neptune",
+    [MONA_OBJECT_PLUTO]      = "Pluto",
+    [MONA_OBJECT_NORTH_NODE] = "North Node",
+    [MONA_OBJECT_SOUTH_NODE] = "South Node",
+
     [MONA_OBJECT_ASCENDANT]    = "Ascendant",
     [MONA_OBJECT_DESCENDANT]   = "Descendant",
     [MONA_OBJECT_MEDIUM_COELI] = "Medium Coeli",
@@ -0,0 +1,129 @@
+/*
+ *  This file is part of libmona
+ *
+ *  Libmona is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  Libmona is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with libmona; if not, see <https://www.gnu.org/licenses/>.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+#include <stdio.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <mona/core.h>
+#include <mona/client.h>
+
+/*  Pipelining check for monad
+
+    Every request is sent before any response is read, from a thread of
+    its own, for counts around and well past what a connection buffers */
+
+#define TIMEOUT 30
+
+struct batch
+{
+    int fd;
+    struct mona_request *requests;
+    size_t count;
+};
+
+static void *
+sender(void *arg)
+{
+    struct batch *b = arg;
+    mona_client_send(b->fd, b->requests, b->count);
+    return NULL;
+}
+
+static int
+check(const char *path, size_t count)
+{
+    struct mona_request *requests = calloc(count, sizeof(*requests));
+    struct mona_response *responses = calloc(count, sizeof(*responses));
+    int fd = mona_client_connect(path);
+    if (!requests || !responses || fd < 0)
+    {
+        perror("pipeline");
+        return 1;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        requests[i].id = i;
+        requests[i].query = MONA_QUERY_ZODIAC;
+        requests[i].object = i % MONA_OBJECT_COUNT;
+        requests[i].utc = 1700000000 + (int64_t)(i / 4) * 600;
+        requests[i].latitude = 48.85;
+        requests[i].longitude = 2.35;
+    }
+
+    struct batch b = {fd, requests, count};
+    pthread_t thread;
+    pthread_create(&thread, NULL, sender, &b);
+    int ret = mona_client_receive(fd, responses, count);
+    pthread_join(thread, NULL);
+    mona_client_close(fd);
+
+    for (size_t i = 0; !ret && i < count; i++)
+    {
+        struct mona_waypoint p = mona_waypoint(requests[i].utc,
+                                               requests[i].latitude,
+                                               requests[i].longitude);
+        struct mona_zodiac z = mona_zodiac(p, requests[i].object);
+        if (responses[i].id != i ||
+            responses[i].status != MONA_STATUS_OK ||
+            responses[i].data.zodiac.position != z.position)
+            ret = 1;
+    }
+
+    printf("%6zu requests %s\n", count, ret ? "failed" : "ok");
+
+    free(requests);
+    free(responses);
+    return ret;
+}
+
+extern int
+main(int argc, char *argv[])
+{
+    const char *path = (argc > 1) ? argv[1] : MONA_SOCKET;
+    static const size_t counts[] = {1, 255, 256, 257, 300, 511, 600, 5000};
+
+    /* A stalled daemon ends the check instead of hanging it */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    alarm(TIMEOUT);
+
+    /* Give the daemon time to bind */
+    struct timespec pause = {0, 100000000};
+    for (int i = 0; i < 50; i++)
+    {
+        int fd = mona_client_connect(path);
+        if (fd >= 0)
+        {
+            mona_client_close(fd);
+            break;
+        }
+        nanosleep(&pause, NULL);
+    }
+
+    int ret = 0;
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+        ret |= check(path, counts[i]);
+
+    return ret;
+}
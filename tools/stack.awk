@@ -0,0 +1,115 @@
+#
+#  This file is part of libmona
+#
+#  Libmona is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU Lesser General Public
+#  License as published by the Free Software Foundation; either
+#  version 2.1 of the License, or (at your option) any later version.
+#
+#  Libmona is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+#  See the GNU Lesser General Public License for more details.
+#
+#  You should have received a copy of the GNU Lesser General Public
+#  License along with libmona; if not, see <https://www.gnu.org/licenses/>.
+#
+
+#  Worst case stack of the public functions, from the call graphs
+#  written by -fcallgraph-info=su, fails above limit bytes unless the
+#  name matches skip, library calls are not counted
+#
+#  awk -v limit=1024 -v skip='^mona_election$' -f tools/stack.awk *.ci
+
+function field(line, key,    s)
+{
+    if (!match(line, key ": \"[^\"]*\""))
+        return ""
+    s = substr(line, RSTART, RLENGTH)
+    sub(key ": \"", "", s)
+    return substr(s, 1, length(s) - 1)
+}
+
+function depth(n,    i, d, best)
+{
+    if (n in worst)
+        return worst[n]
+    if (!(n in frame))
+    {
+        external = 1
+        return 0
+    }
+    if (visiting[n])
+    {
+        recursive = 1
+        return 0
+    }
+
+    visiting[n] = 1
+    best = 0
+    for (i = 1; i <= calls[n]; i++)
+    {
+        d = depth(callee[n, i])
+        best = (d > best) ? d : best
+    }
+    visiting[n] = 0
+
+    worst[n] = frame[n] + best
+    return worst[n]
+}
+
+/^node:/ {
+    n = field($0, "title")
+    label = field($0, "label")
+    if (match(label, /[0-9]+ bytes/))
+        frame[n] = substr(label, RSTART, RLENGTH) + 0
+}
+
+/^edge:/ {
+    n = field($0, "sourcename")
+    calls[n]++
+    callee[n, calls[n]] = field($0, "targetname")
+}
+
+END {
+    if (limit == "")
+        limit = 1024
+
+    status = 0
+    count = 0
+    for (n in frame)
+    {
+        if (n !~ /^mona_/)
+            continue
+        names[++count] = n
+    }
+
+    for (i = 2; i <= count; i++)
+    {
+        for (j = i; j > 1 && names[j - 1] > names[j]; j--)
+        {
+            t = names[j]; names[j] = names[j - 1]; names[j - 1] = t
+        }
+    }
+
+    for (i = 1; i <= count; i++)
+    {
+        n = names[i]
+        external = recursive = 0
+        for (m in worst)
+            delete worst[m]
+
+        d = depth(n)
+        note = external ? " + libc" : ""
+        note = note (recursive ? ", recursive" : "")
+        printf "%-24s %6d%s\n", n, d, note
+
+        if (d > limit && (skip == "" || n !~ skip))
+        {
+            printf "%s exceeds %d bytes of stack\n", n, limit > "/dev/stderr"
+            status = 1
+        }
+    }
+
+    exit status
+}